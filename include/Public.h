@@ -127,6 +127,20 @@ typedef struct __attribute__((packed)) _GLOBAL_START_DMA_CONFIGURATION
     START_DMA_CHANNEL_CONFIGURATION StartDmaChannels[MAX_NUM_CHANNELS];
 } GLOBAL_START_DMA_CONFIGURATION;
 
+///< Record header for channels with read size in header (see MAX_NUM_CHANNELS_WITH_HEADER)
+///< A zero Magic word at a record boundary marks the end of data; the rest of the buffer is unused
+#define DMA_RECORD_HEADER_MAGIC 0x44524345 ///< Magic value at the start of every record header
+#define DMA_RECORD_FLAG_CHECKSUM 0x0001    ///< Checksum field holds the 32-bit word sum of the payload
+#define DMA_RECORD_ALIGNMENT 64            ///< Records start on a 64-byte boundary inside the descriptor buffer
+
+typedef struct __attribute__((packed)) _DMA_RECORD_HEADER
+{
+    uint32_t Magic;    ///< DMA_RECORD_HEADER_MAGIC
+    uint32_t Size;     ///< Payload size in bytes, header excluded
+    uint32_t Flags;    ///< DMA_RECORD_FLAG_* bits
+    uint32_t Checksum; ///< Payload checksum, valid when DMA_RECORD_FLAG_CHECKSUM is set
+} DMA_RECORD_HEADER;
+
 ///< Device type definition for IOCTL
 #define FILE_DEVICE_PCIE 0x9000 ///< Device type definition for IOCTL
 
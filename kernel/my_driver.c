@@ -7,6 +7,9 @@
 #include "my_driver.h"
 #include "../include/Public.h"
 
+#define CREATE_TRACE_POINTS
+#include "my_driver_trace.h"
+
 static struct my_dev *my_dev;
 
 static int my_driver_open(struct inode *inodep, struct file *filep)
@@ -24,26 +27,27 @@ static int my_driver_release(struct inode *inodep, struct file *filep)
 static long my_driver_ioctl(struct file *filep, unsigned int cmd, unsigned long arg)
 {
     REGESTRY_PARAMS user_params;
+    long ret = 0;
 
     switch (cmd)
     {
     case IOCTL_SET_DMA_REG:
         if (copy_from_user(&user_params, (REGESTRY_PARAMS *)arg, sizeof(REGESTRY_PARAMS)))
         {
-            return -EFAULT;
+            ret = -EFAULT;
+            break;
         }
-        pr_info("my_driver: Writing value %u to BAR %u, offset %llu\n",
-                user_params.value, user_params.bar, user_params.address);
+        trace_my_driver_reg_access(true, user_params.bar, user_params.address, user_params.value);
         break;
 
     case IOCTL_GET_DMA_REG:
         user_params.value = 1234;
         if (copy_to_user((REGESTRY_PARAMS *)arg, &user_params, sizeof(REGESTRY_PARAMS)))
         {
-            return -EFAULT;
+            ret = -EFAULT;
+            break;
         }
-        pr_info("my_driver: Read value %u from BAR %u, offset %llu\n",
-                user_params.value, user_params.bar, user_params.address);
+        trace_my_driver_reg_access(false, user_params.bar, user_params.address, user_params.value);
         break;
 
     case IOCTL_GLOBAL_DMA_CONFIGURATION_GET:
@@ -52,44 +56,52 @@ static long my_driver_ioctl(struct file *filep, unsigned int cmd, unsigned long
         dmaParam.DmaDescriptorsMaxCount = MAX_NUM_DESCRIPTORS;
         if (copy_to_user((GLOBAL_DATA_DMA_PARAMETERS __user *)arg, &dmaParam, sizeof(dmaParam)))
         {
-            return -EFAULT;
+            ret = -EFAULT;
+            break;
         }
-        pr_info("DMA: Global DMA configuration\n");
+        trace_my_driver_config(cmd);
         break;
 
     case IOCTL_GLOBAL_EVENT_HANDLE_SET:
         int sharedEventHandle[MAX_NUM_CHANNELS * MAX_NUM_DESCRIPTORS];
         if (copy_from_user(sharedEventHandle, (int __user *)arg, sizeof(sharedEventHandle)))
         {
-            return -EFAULT;
+            ret = -EFAULT;
+            break;
         }
-        pr_info("DMA: Received event handles\n");
+        trace_my_driver_config(cmd);
         break;
 
     case IOCTL_GLOBAL_EVENT_HANDLE_GET:
         GLOBAL_EVENT_HANDLE_DATA eventData;
         if (copy_to_user((GLOBAL_EVENT_HANDLE_DATA __user *)arg, &eventData, sizeof(eventData)))
         {
-            return -EFAULT;
+            ret = -EFAULT;
+            break;
         }
-        pr_info("DMA: Global event handle\n");
+        trace_my_driver_config(cmd);
         break;
 
     case IOCTL_GLOBAL_MEM_MAP_GET:
         GLOBAL_MEM_MAP_DATA memoryData;
         if (copy_to_user((GLOBAL_MEM_MAP_DATA __user *)arg, &memoryData, sizeof(memoryData)))
         {
-            return -EFAULT;
+            ret = -EFAULT;
+            break;
         }
-        pr_info("DMA: Global mem map\n");
+        trace_my_driver_config(cmd);
         break;
 
     default:
-        pr_info("IOCTL: default");
-        return -EINVAL;
+        ret = -EINVAL;
+        break;
     }
 
-    return 0;
+    if (ret)
+    {
+        trace_my_driver_error(cmd, ret);
+    }
+    return ret;
 }
 
 static struct file_operations fops = {
@@ -0,0 +1,66 @@
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM my_driver
+
+#if !defined(MY_DRIVER_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define MY_DRIVER_TRACE_H
+
+#include <linux/tracepoint.h>
+
+/*
+ * Tracepoints replace pr_info on the ioctl path. They are switched at runtime
+ * through tracefs (events/my_driver/) and cost a patched-out branch when off.
+ */
+
+TRACE_EVENT(my_driver_reg_access,
+    TP_PROTO(bool is_write, u8 bar, u64 address, u32 value),
+    TP_ARGS(is_write, bar, address, value),
+    TP_STRUCT__entry(
+        __field(bool, is_write)
+        __field(u8, bar)
+        __field(u64, address)
+        __field(u32, value)
+    ),
+    TP_fast_assign(
+        __entry->is_write = is_write;
+        __entry->bar = bar;
+        __entry->address = address;
+        __entry->value = value;
+    ),
+    TP_printk("%s bar=%u address=0x%llx value=0x%x",
+              __entry->is_write ? "write" : "read",
+              __entry->bar, __entry->address, __entry->value)
+);
+
+TRACE_EVENT(my_driver_config,
+    TP_PROTO(unsigned int cmd),
+    TP_ARGS(cmd),
+    TP_STRUCT__entry(
+        __field(unsigned int, cmd)
+    ),
+    TP_fast_assign(
+        __entry->cmd = cmd;
+    ),
+    TP_printk("cmd=0x%x", __entry->cmd)
+);
+
+TRACE_EVENT(my_driver_error,
+    TP_PROTO(unsigned int cmd, long err),
+    TP_ARGS(cmd, err),
+    TP_STRUCT__entry(
+        __field(unsigned int, cmd)
+        __field(long, err)
+    ),
+    TP_fast_assign(
+        __entry->cmd = cmd;
+        __entry->err = err;
+    ),
+    TP_printk("cmd=0x%x err=%ld", __entry->cmd, __entry->err)
+);
+
+#endif // MY_DRIVER_TRACE_H
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE my_driver_trace
+#include <trace/define_trace.h>
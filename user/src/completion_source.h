@@ -0,0 +1,29 @@
+#ifndef COMPLETION_SOURCE_H
+#define COMPLETION_SOURCE_H
+
+#include <cstdint>
+
+///< One completed DMA descriptor as seen by the consumer
+struct dma_completion
+{
+    uint32_t channel;
+    uint32_t descriptor;
+    const void *buffer; ///< Descriptor buffer, valid until the descriptor completes again
+    uint32_t size;      ///< Bytes in buffer
+};
+
+/*
+ * Stream of descriptor completions. Implemented by driver_interface for the
+ * device and by session_replay for recorded sessions, so consumer code runs
+ * unchanged against either.
+ */
+class completion_source
+{
+public:
+    virtual ~completion_source() = default;
+
+    ///< Returns false when nothing completed within timeoutMs (negative waits forever)
+    virtual bool wait_completion(dma_completion &completion, int timeoutMs) = 0;
+};
+
+#endif // COMPLETION_SOURCE_H
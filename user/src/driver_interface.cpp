@@ -1,6 +1,7 @@
 #include "driver_interface.h"
 #include <sys/eventfd.h>
-#include <sstream>
+#include <cerrno>
+#include "driver_trace.h"
 
 std::mutex driver_interface::g_mutex;
 
@@ -31,7 +32,12 @@ bool driver_interface::send_ioctl(unsigned long ioctlCode, void *arg)
         throw std::runtime_error("Invalid driver handle");
     }
 
-    return ioctl(driverHandle_, ioctlCode, arg) >= 0;
+    if (ioctl(driverHandle_, ioctlCode, arg) < 0)
+    {
+        driver_trace::record(trace_event::error, 0, ioctlCode, errno);
+        return false;
+    }
+    return true;
 }
 
 void driver_interface::write_register(uint8_t bar, uint64_t registerOffset, uint32_t value)
@@ -41,6 +47,8 @@ void driver_interface::write_register(uint8_t bar, uint64_t registerOffset, uint
     {
         throw std::runtime_error("Failed to write to register");
     }
+    recorder_.record_register(true, info);
+    driver_trace::record(trace_event::register_write, bar, registerOffset, value);
 }
 
 uint32_t driver_interface::read_register(uint8_t bar, uint64_t registerOffset)
@@ -50,6 +58,8 @@ uint32_t driver_interface::read_register(uint8_t bar, uint64_t registerOffset)
     {
         throw std::runtime_error("Failed to read from register");
     }
+    recorder_.record_register(false, info);
+    driver_trace::record(trace_event::register_read, bar, registerOffset, info.value);
     return info.value;
 }
 
@@ -74,15 +84,18 @@ void driver_interface::read_DMA_memory_map_and_event_handles(GLOBAL_DATA_DMA_PAR
             throw std::runtime_error("Failed to call IOCTL_GLOBAL_DMA_CONFIGURATION_GET");
         }
 
-        pid_t processID = getpid();
+        if (dmaParam.DmaChannelsMaxCount > MAX_NUM_CHANNELS || dmaParam.DmaDescriptorsMaxCount > MAX_NUM_DESCRIPTORS)
+        {
+            throw std::runtime_error("Invalid DMA configuration from driver");
+        }
+
+        eventPoll_.clear();
+        nextEvent_ = 0;
+        descriptorsMaxCount_ = dmaParam.DmaDescriptorsMaxCount;
         for (uint32_t channel = 0; channel < dmaParam.DmaChannelsMaxCount; ++channel)
         {
             for (uint32_t descriptor = 0; descriptor < dmaParam.DmaDescriptorsMaxCount; ++descriptor)
             {
-                std::stringstream ss;
-                ss << "/dev/shm/dma_event_" << processID << "_C" << channel << "_D" << descriptor;
-                std::string eventName = ss.str();
-
                 int index = channel * dmaParam.DmaDescriptorsMaxCount + descriptor;
                 sharedEventHandle_[index] = eventfd(0, EFD_NONBLOCK);
                 if (sharedEventHandle_[index] == -1)
@@ -90,7 +103,8 @@ void driver_interface::read_DMA_memory_map_and_event_handles(GLOBAL_DATA_DMA_PAR
                     throw std::runtime_error("Cannot create event for channel " + std::to_string(channel));
                 }
 
-                std::cout << "Created event: " << eventName << " for channel = " << channel << " and descriptor = " << descriptor << std::endl;
+                eventPoll_.push_back({sharedEventHandle_[index], POLLIN, 0});
+                driver_trace::record(trace_event::event_created, channel, descriptor, sharedEventHandle_[index]);
             }
         }
 
@@ -108,6 +122,7 @@ void driver_interface::read_DMA_memory_map_and_event_handles(GLOBAL_DATA_DMA_PAR
         {
             throw std::runtime_error("Failed to call IOCTL_GLOBAL_MEM_MAP_GET");
         }
+        memoryMap_ = memoryData;
     };
 
     read_memory_map();
@@ -134,7 +149,7 @@ void driver_interface::start_stop_DMA_channel(uint8_t channel, bool isStartDmaCh
             DmaControlValue |= 0x00000008;
         }
 
-        std::cout << "StartStopDmaChannel" << std::endl;
+        driver_trace::record(trace_event::dma_channel, channel, isStartDmaChannel, isCycle);
         write_register(0, trans_form_fpga_address(DEVICE_GLOBAL_DMA_REG_CONTROL) + 0x40 * channel, DmaControlValue);
     };
 
@@ -155,6 +170,8 @@ void driver_interface::start_stop_DMA_global(bool isStartDmaGlobal, bool isRx)
         uint32_t value = isStartDmaGlobal ? 0x00000001 : 0x00000000;
         uint64_t address = isRx ? DEVICE_GLOBAL_RX_DMA_ENABLE_FPGA_DATA : DEVICE_GLOBAL_TX_DMA_ENABLE_FPGA_DATA;
 
+        driver_trace::record(trace_event::dma_global, 0, isStartDmaGlobal, isRx);
+
         write_register(0, trans_form_fpga_address(address), value);
     };
 
@@ -176,6 +193,8 @@ void driver_interface::start_DMA_configure(GLOBAL_START_DMA_CONFIGURATION &start
         write_register(0, trans_form_fpga_address(DEVICE_GLOBAL_INTERRUPT_FPGA_DATA), 0x00FF);
 
         int NumberOfChannels = std::min(startDmaConfiguration.DmaChannelsCount, static_cast<uint32_t>(MAX_NUM_CHANNELS));
+        driver_trace::record(trace_event::dma_configure, NumberOfChannels);
+        recorder_.record_configuration(startDmaConfiguration);
         for (int channel = 0; channel < NumberOfChannels; channel++)
         {
             int NumberOfDescriptors = std::min(startDmaConfiguration.StartDmaChannels[channel].DmaDescriptorsCount, static_cast<uint32_t>(MAX_NUM_DESCRIPTORS));
@@ -195,6 +214,7 @@ void driver_interface::start_DMA_configure(GLOBAL_START_DMA_CONFIGURATION &start
 
                 uint32_t DmaBufferSize = std::min(startDmaConfiguration.StartDmaChannels[channel].StartDmaDescriptors[descriptor].DmaDescriptorBufferSize, static_cast<uint32_t>(DESCRIPTOR_BUFFER_SIZE));
                 write_register(0, trans_form_fpga_address(DEVICE_GLOBAL_DMA_REG_DESCRIPTORS_TABLE) + 0x400 * channel + 0x10 * descriptor + 0x8, DmaBufferSize | (1 << 31));
+                descriptorBufferSize_[channel][descriptor] = DmaBufferSize;
 
                 uint32_t IsDescriptorInterruptEnable = std::min(startDmaConfiguration.StartDmaChannels[channel].StartDmaDescriptors[descriptor].IsDescriptorInterruptEnable, static_cast<uint32_t>(true));
                 write_register(0, trans_form_fpga_address(DEVICE_GLOBAL_DMA_REG_DESCRIPTORS_TABLE) + 0x400 * channel + 0x10 * descriptor + 0xc, IsDescriptorInterruptEnable);
@@ -206,3 +226,70 @@ void driver_interface::start_DMA_configure(GLOBAL_START_DMA_CONFIGURATION &start
 
     configuration_start_DMA();
 }
+
+bool driver_interface::wait_completion(dma_completion &completion, int timeoutMs)
+{
+    if (eventPoll_.empty())
+    {
+        throw std::runtime_error("Event handles not created");
+    }
+
+    int ready = poll(eventPoll_.data(), eventPoll_.size(), timeoutMs);
+    if (ready < 0)
+    {
+        throw std::runtime_error("Failed to poll DMA events");
+    }
+    if (ready == 0)
+    {
+        return false;
+    }
+    // Taken before any recording work so recorded gaps reflect the device, not the recorder
+    uint64_t timestampNs = session_recorder::timestamp_ns();
+
+    // Start after the last reported event so busy descriptors cannot starve the others
+    for (size_t i = 0; i < eventPoll_.size(); i++)
+    {
+        size_t index = (nextEvent_ + i) % eventPoll_.size();
+        if (!(eventPoll_[index].revents & POLLIN))
+        {
+            continue;
+        }
+
+        uint64_t count;
+        if (read(eventPoll_[index].fd, &count, sizeof(count)) != sizeof(count))
+        {
+            continue;
+        }
+
+        uint32_t channel = index / descriptorsMaxCount_;
+        uint32_t descriptor = index % descriptorsMaxCount_;
+        completion.channel = channel;
+        completion.descriptor = descriptor;
+        {
+            // start_DMA_configure may update the sizes from another thread
+            std::lock_guard<std::mutex> lock(g_mutex);
+            completion.buffer = reinterpret_cast<const void *>(static_cast<uintptr_t>(memoryMap_.DataMemoryDmaChannels[channel].DmaMemoryDescriptors[descriptor].BufferVA));
+            completion.size = descriptorBufferSize_[channel][descriptor];
+        }
+        nextEvent_ = index + 1;
+
+        driver_trace::record(trace_event::completion, channel, descriptor, completion.size);
+        recorder_.record_completion(completion, timestampNs);
+        return true;
+    }
+
+    return false;
+}
+
+void driver_interface::start_recording(const char *path, bool isPayloadRecorded)
+{
+    recorder_.open(path, isPayloadRecorded);
+}
+
+void driver_interface::stop_recording()
+{
+    if (!recorder_.close())
+    {
+        throw std::runtime_error("Session recording failed, file is incomplete");
+    }
+}
@@ -2,19 +2,23 @@
 #define DRIVER_INTERFACE_H
 
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
 #include <cstring>
+#include <vector>
 #include "Public.h"
+#include "completion_source.h"
+#include "session_recorder.h"
 
-class driver_interface
+class driver_interface : public completion_source
 {
 public:
     explicit driver_interface(const char *devicePath);
-    ~driver_interface();
+    ~driver_interface() override;
 
     bool send_ioctl(unsigned long ioctlCode, void *inBuffer);
 
@@ -29,9 +33,24 @@ public:
     void start_stop_DMA_global(bool isStartDmaGlobal, bool isRx);
     void start_DMA_configure(GLOBAL_START_DMA_CONFIGURATION &startDmaConfiguration, GLOBAL_MEM_MAP_DATA &data);
 
+    ///< Requires read_DMA_memory_map_and_event_handles; not to be called concurrently with it or with itself.
+    ///< Safe against start_DMA_configure on another thread.
+    bool wait_completion(dma_completion &completion, int timeoutMs) override;
+
+    ///< Records register operations, the start configuration and every completion returned by wait_completion
+    void start_recording(const char *path, bool isPayloadRecorded);
+    ///< Throws when the recording was cut short by a write error
+    void stop_recording();
+
 private:
     int driverHandle_ = -1;
     int sharedEventHandle_[MAX_NUM_CHANNELS * MAX_NUM_DESCRIPTORS];
+    uint32_t descriptorsMaxCount_ = 0;
+    std::vector<pollfd> eventPoll_;
+    size_t nextEvent_ = 0;
+    GLOBAL_MEM_MAP_DATA memoryMap_ = {};
+    uint32_t descriptorBufferSize_[MAX_NUM_CHANNELS][MAX_NUM_DESCRIPTORS] = {};
+    session_recorder recorder_;
     static std::mutex g_mutex;
 };
 
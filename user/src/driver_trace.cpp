@@ -0,0 +1,155 @@
+#include "driver_trace.h"
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    static_assert((DRIVER_TRACE_RING_RECORDS & (DRIVER_TRACE_RING_RECORDS - 1)) == 0, "Ring size must be a power of 2");
+    static_assert(sizeof(trace_record) % sizeof(uint64_t) == 0, "Trace record must be whole 64-bit words");
+
+    const size_t g_slotWords = sizeof(trace_record) / sizeof(uint64_t);
+
+    // Slots are relaxed atomic words so dump() may read them while the owner writes
+    struct trace_slot
+    {
+        std::atomic<uint64_t> words[g_slotWords];
+    };
+
+    /*
+     * Single-writer ring read seqlock style: the owner bumps reserve before
+     * overwriting a slot and publishes it through head afterwards, so a reader
+     * that copied a slot and then sees reserve can tell whether it was reused.
+     */
+    struct trace_ring
+    {
+        uint32_t threadId = 0;
+        bool isFree = false; ///< Owner thread exited; guarded by g_ringsMutex
+        std::atomic<uint64_t> reserve{0};
+        std::atomic<uint64_t> head{0};
+        trace_slot slots[DRIVER_TRACE_RING_RECORDS];
+    };
+
+    // A ring outlives its thread so a dump still sees it, until a new thread reuses it.
+    // Memory is bounded by the peak number of threads tracing at the same time.
+    std::mutex g_ringsMutex;
+    std::vector<std::unique_ptr<trace_ring>> g_rings;
+
+    trace_ring *acquire_ring()
+    {
+        uint32_t threadId = static_cast<uint32_t>(syscall(SYS_gettid));
+
+        std::lock_guard<std::mutex> lock(g_ringsMutex);
+        for (const auto &ring : g_rings)
+        {
+            if (ring->isFree)
+            {
+                ring->isFree = false;
+                ring->threadId = threadId;
+                ring->reserve.store(0, std::memory_order_relaxed);
+                ring->head.store(0, std::memory_order_relaxed);
+                return ring.get();
+            }
+        }
+
+        g_rings.push_back(std::unique_ptr<trace_ring>(new trace_ring()));
+        g_rings.back()->threadId = threadId;
+        return g_rings.back().get();
+    }
+
+    // Hands the ring back for reuse when the owning thread exits
+    struct ring_owner
+    {
+        trace_ring *ring = acquire_ring();
+
+        ~ring_owner()
+        {
+            std::lock_guard<std::mutex> lock(g_ringsMutex);
+            ring->isFree = true;
+        }
+    };
+
+    uint64_t timestamp_ns()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    }
+}
+
+void driver_trace::record_slow(trace_event event, uint32_t arg0, uint64_t arg1, uint64_t arg2)
+{
+    thread_local ring_owner owner;
+    trace_ring *ring = owner.ring;
+
+    trace_record record = {timestamp_ns(), static_cast<uint16_t>(event), 0, arg0, arg1, arg2};
+    uint64_t words[g_slotWords];
+    std::memcpy(words, &record, sizeof(record));
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    ring->reserve.store(head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    trace_slot &slot = ring->slots[head & (DRIVER_TRACE_RING_RECORDS - 1)];
+    for (size_t i = 0; i < g_slotWords; i++)
+    {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void driver_trace::dump(const char *path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error(std::string("Failed to open trace file ") + path);
+    }
+
+    std::lock_guard<std::mutex> lock(g_ringsMutex);
+
+    trace_file_header fileHeader = {DRIVER_TRACE_FILE_MAGIC, DRIVER_TRACE_FILE_VERSION, sizeof(trace_record), static_cast<uint32_t>(g_rings.size())};
+    file.write(reinterpret_cast<const char *>(&fileHeader), sizeof(fileHeader));
+
+    std::vector<trace_record> records(DRIVER_TRACE_RING_RECORDS);
+    for (const auto &ring : g_rings)
+    {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head < DRIVER_TRACE_RING_RECORDS ? 0 : head - DRIVER_TRACE_RING_RECORDS;
+
+        for (uint64_t i = first; i < head; i++)
+        {
+            const trace_slot &slot = ring->slots[i & (DRIVER_TRACE_RING_RECORDS - 1)];
+            uint64_t words[g_slotWords];
+            for (size_t w = 0; w < g_slotWords; w++)
+            {
+                words[w] = slot.words[w].load(std::memory_order_relaxed);
+            }
+            std::memcpy(&records[i - first], words, sizeof(trace_record));
+        }
+
+        // Drop the oldest slots the owner may have overwritten while they were copied
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t reserve = ring->reserve.load(std::memory_order_relaxed);
+        uint64_t valid = reserve > DRIVER_TRACE_RING_RECORDS ? reserve - DRIVER_TRACE_RING_RECORDS : 0;
+        uint64_t skip = valid > first ? std::min(valid - first, head - first) : 0;
+
+        uint32_t count = static_cast<uint32_t>(head - first - skip);
+        trace_thread_header threadHeader = {ring->threadId, count, first + skip};
+        file.write(reinterpret_cast<const char *>(&threadHeader), sizeof(threadHeader));
+        file.write(reinterpret_cast<const char *>(records.data() + skip), count * sizeof(trace_record));
+    }
+
+    if (!file)
+    {
+        throw std::runtime_error(std::string("Failed to write trace file ") + path);
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef DRIVER_TRACE_H
+#define DRIVER_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+#define DRIVER_TRACE_FILE_MAGIC 0x45435254 ///< "TRCE"
+#define DRIVER_TRACE_FILE_VERSION 1
+#define DRIVER_TRACE_RING_RECORDS 16384 ///< Records kept per thread, power of 2
+
+enum class trace_event : uint16_t
+{
+    register_write,  ///< arg0 bar, arg1 address, arg2 value
+    register_read,   ///< arg0 bar, arg1 address, arg2 value
+    event_created,   ///< arg0 channel, arg1 descriptor, arg2 eventfd
+    dma_channel,     ///< arg0 channel, arg1 start, arg2 cycle
+    dma_global,      ///< arg1 start, arg2 rx
+    dma_configure,   ///< arg0 channels count
+    completion,      ///< arg0 channel, arg1 descriptor, arg2 size
+    error,           ///< arg1 ioctl code, arg2 errno
+};
+
+///< Binary record as stored in the per-thread ring and in the dump file
+struct __attribute__((packed)) trace_record
+{
+    uint64_t timestampNs; ///< CLOCK_MONOTONIC
+    uint16_t event;
+    uint16_t reserved;
+    uint32_t arg0;
+    uint64_t arg1;
+    uint64_t arg2;
+};
+
+struct __attribute__((packed)) trace_file_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t threadCount;
+};
+
+///< Precedes the records of one thread in the dump file
+struct __attribute__((packed)) trace_thread_header
+{
+    uint32_t threadId;
+    uint32_t recordCount;
+    uint64_t dropped; ///< Records overwritten before the dump
+};
+
+/*
+ * Per-thread binary trace rings. Each thread writes only to its own ring, so
+ * recording takes no lock; when tracing is disabled record() is a single
+ * relaxed load. Rings are written to a file by dump() and decoded offline
+ * with trace_decode. A ring takes DRIVER_TRACE_RING_RECORDS * 32 bytes and is
+ * reused by a new thread once its owner exits.
+ */
+class driver_trace
+{
+public:
+    static void enable(bool isEnabled)
+    {
+        enabled_.store(isEnabled, std::memory_order_relaxed);
+    }
+
+    static bool is_enabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    static void record(trace_event event, uint32_t arg0 = 0, uint64_t arg1 = 0, uint64_t arg2 = 0)
+    {
+        if (is_enabled())
+        {
+            record_slow(event, arg0, arg1, arg2);
+        }
+    }
+
+    ///< Safe while threads trace; records overwritten during the copy are dropped
+    static void dump(const char *path);
+
+private:
+    static void record_slow(trace_event event, uint32_t arg0, uint64_t arg1, uint64_t arg2);
+
+    static inline std::atomic<bool> enabled_{false};
+};
+
+#endif // DRIVER_TRACE_H
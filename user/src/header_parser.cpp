@@ -0,0 +1,207 @@
+#include "header_parser.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HEADER_PARSER_X86 1
+#endif
+
+namespace
+{
+    // Word sum of the partial word left after the vector loops, zero padded
+    uint32_t checksum_tail(const uint8_t *data, size_t length)
+    {
+        uint32_t sum = 0;
+        size_t i = 0;
+        for (; i + 4 <= length; i += 4)
+        {
+            uint32_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            sum += word;
+        }
+        if (i < length)
+        {
+            uint32_t word = 0;
+            std::memcpy(&word, data + i, length - i);
+            sum += word;
+        }
+        return sum;
+    }
+
+#ifdef HEADER_PARSER_X86
+    __attribute__((target("sse2"))) uint32_t checksum_sse2(const uint8_t *data, size_t length)
+    {
+        __m128i acc0 = _mm_setzero_si128();
+        __m128i acc1 = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32)
+        {
+            acc0 = _mm_add_epi32(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+            acc1 = _mm_add_epi32(acc1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 16)));
+        }
+        acc0 = _mm_add_epi32(acc0, acc1);
+        acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(1, 0, 3, 2)));
+        acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(acc0)) + checksum_tail(data + i, length - i);
+    }
+
+    __attribute__((target("avx2"))) uint32_t checksum_avx2(const uint8_t *data, size_t length)
+    {
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        __m256i acc2 = _mm256_setzero_si256();
+        __m256i acc3 = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 128 <= length; i += 128)
+        {
+            acc0 = _mm256_add_epi32(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+            acc1 = _mm256_add_epi32(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 32)));
+            acc2 = _mm256_add_epi32(acc2, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 64)));
+            acc3 = _mm256_add_epi32(acc3, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 96)));
+        }
+        for (; i + 32 <= length; i += 32)
+        {
+            acc0 = _mm256_add_epi32(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+        }
+        acc0 = _mm256_add_epi32(_mm256_add_epi32(acc0, acc1), _mm256_add_epi32(acc2, acc3));
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(sum)) + checksum_tail(data + i, length - i);
+    }
+#endif
+}
+
+header_parser::header_parser(bool verifyChecksum)
+    : isa_(detect_isa()), verifyChecksum_(verifyChecksum)
+{
+}
+
+header_parser::header_parser(isa forcedIsa, bool verifyChecksum)
+    : isa_(forcedIsa), verifyChecksum_(verifyChecksum)
+{
+    if (static_cast<int>(forcedIsa) > static_cast<int>(detect_isa()))
+    {
+        throw std::runtime_error(std::string("Instruction set not supported by CPU: ") + isa_name(forcedIsa));
+    }
+}
+
+header_parser::isa header_parser::selected_isa() const
+{
+    return isa_;
+}
+
+header_parser::isa header_parser::detect_isa()
+{
+#ifdef HEADER_PARSER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return isa::avx2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return isa::sse2;
+    }
+#endif
+    return isa::scalar;
+}
+
+const char *header_parser::isa_name(isa value)
+{
+    switch (value)
+    {
+    case isa::avx2:
+        return "avx2";
+    case isa::sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+uint32_t header_parser::checksum(const void *data, size_t length, isa value)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    switch (value)
+    {
+#ifdef HEADER_PARSER_X86
+    case isa::avx2:
+        return checksum_avx2(bytes, length);
+    case isa::sse2:
+        return checksum_sse2(bytes, length);
+#endif
+    default:
+        return checksum_tail(bytes, length);
+    }
+}
+
+parse_result header_parser::parse(const void *buffer, size_t length, std::vector<record_index_entry> &index) const
+{
+    if (buffer == nullptr)
+    {
+        throw std::runtime_error("Invalid buffer");
+    }
+    if (length > DESCRIPTOR_BUFFER_SIZE)
+    {
+        throw std::runtime_error("Buffer exceeds descriptor buffer size");
+    }
+
+    const uint8_t *base = static_cast<const uint8_t *>(buffer);
+    parse_result result;
+    size_t offset = 0;
+
+    while (offset < length)
+    {
+        // Zero Magic at a record boundary terminates the data, even in a short tail
+        uint32_t magic = 0;
+        std::memcpy(&magic, base + offset, std::min(sizeof(magic), length - offset));
+        if (magic == 0)
+        {
+            break;
+        }
+
+        if (length - offset < sizeof(DMA_RECORD_HEADER))
+        {
+            result.status = parse_status::truncated;
+            break;
+        }
+
+        DMA_RECORD_HEADER header;
+        std::memcpy(&header, base + offset, sizeof(header));
+        if (header.Magic != DMA_RECORD_HEADER_MAGIC || header.Size > DESCRIPTOR_BUFFER_SIZE - sizeof(DMA_RECORD_HEADER))
+        {
+            result.status = parse_status::invalid_header;
+            break;
+        }
+
+        size_t recordEnd = offset + sizeof(DMA_RECORD_HEADER) + header.Size;
+        if (recordEnd > length)
+        {
+            result.status = parse_status::truncated;
+            break;
+        }
+
+        if (verifyChecksum_ && (header.Flags & DMA_RECORD_FLAG_CHECKSUM) &&
+            checksum(base + offset + sizeof(DMA_RECORD_HEADER), header.Size, isa_) != header.Checksum)
+        {
+            result.status = parse_status::checksum_mismatch;
+            break;
+        }
+
+        index.push_back({static_cast<uint32_t>(offset), header.Size});
+        result.recordCount++;
+        offset = ALIGN_X(recordEnd, static_cast<size_t>(DMA_RECORD_ALIGNMENT));
+    }
+
+    result.bytesConsumed = std::min(offset, length);
+    return result;
+}
+
+parse_result header_parser::parse(const DATA_MEMORY_DMA_DESCRIPTOR &descriptor, size_t length, std::vector<record_index_entry> &index) const
+{
+    return parse(reinterpret_cast<const void *>(static_cast<uintptr_t>(descriptor.BufferVA)), length, index);
+}
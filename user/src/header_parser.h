@@ -0,0 +1,66 @@
+#ifndef HEADER_PARSER_H
+#define HEADER_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Public.h"
+
+///< One parsed record: offset of its header inside the descriptor buffer and payload size
+struct record_index_entry
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+enum class parse_status
+{
+    ok,                ///< Records end at the buffer end or at a zero Magic terminator
+    truncated,         ///< Last record header or payload runs past the buffer end
+    invalid_header,    ///< Header magic mismatch or record size out of range
+    checksum_mismatch, ///< Payload checksum differs from the header
+};
+
+struct parse_result
+{
+    parse_status status = parse_status::ok;
+    size_t recordCount = 0;   ///< Records appended to the index
+    size_t bytesConsumed = 0; ///< Offset of the first byte not covered by a valid record (end of data when ok)
+};
+
+/*
+ * Walks a completed descriptor buffer of a header-framed channel and builds
+ * the record index. The header walk is scalar since every record size decides
+ * where the next header is; only the payload checksum runs on AVX2, SSE2 or
+ * scalar code, selected once at construction from the running CPU.
+ */
+class header_parser
+{
+public:
+    enum class isa
+    {
+        scalar,
+        sse2,
+        avx2,
+    };
+
+    explicit header_parser(bool verifyChecksum = true);
+    header_parser(isa forcedIsa, bool verifyChecksum);
+
+    ///< Records are appended to index; parsing stops at the first bad or truncated record
+    parse_result parse(const void *buffer, size_t length, std::vector<record_index_entry> &index) const;
+    ///< Parses a mapped descriptor buffer in place through its BufferVA
+    parse_result parse(const DATA_MEMORY_DMA_DESCRIPTOR &descriptor, size_t length, std::vector<record_index_entry> &index) const;
+
+    isa selected_isa() const;
+
+    static isa detect_isa();
+    static const char *isa_name(isa value);
+    static uint32_t checksum(const void *data, size_t length, isa value);
+
+private:
+    isa isa_;
+    bool verifyChecksum_;
+};
+
+#endif // HEADER_PARSER_H
@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "header_parser.h"
+
+namespace
+{
+    // Fills the buffer with back-to-back checksummed records, the last one cut at the buffer end
+    void fill_records(uint8_t *buffer, size_t length, uint32_t payloadSize)
+    {
+        std::memset(buffer, 0, length);
+        size_t offset = 0;
+        uint32_t seed = 1;
+        while (offset + sizeof(DMA_RECORD_HEADER) <= length)
+        {
+            uint8_t *payload = buffer + offset + sizeof(DMA_RECORD_HEADER);
+            size_t available = length - offset - sizeof(DMA_RECORD_HEADER);
+            size_t fill = std::min(static_cast<size_t>(payloadSize), available);
+            for (size_t i = 0; i < fill; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                payload[i] = static_cast<uint8_t>(seed >> 16);
+            }
+
+            DMA_RECORD_HEADER header = {DMA_RECORD_HEADER_MAGIC, payloadSize, DMA_RECORD_FLAG_CHECKSUM,
+                                        header_parser::checksum(payload, fill, header_parser::isa::scalar)};
+            std::memcpy(buffer + offset, &header, sizeof(header));
+            offset = ALIGN_X(offset + sizeof(DMA_RECORD_HEADER) + payloadSize, static_cast<size_t>(DMA_RECORD_ALIGNMENT));
+        }
+    }
+
+    const char *status_name(parse_status status)
+    {
+        switch (status)
+        {
+        case parse_status::ok:
+            return "ok";
+        case parse_status::truncated:
+            return "truncated";
+        case parse_status::invalid_header:
+            return "invalid_header";
+        default:
+            return "checksum_mismatch";
+        }
+    }
+
+    const header_parser::isa g_isas[] = {header_parser::isa::scalar, header_parser::isa::sse2, header_parser::isa::avx2};
+
+    bool is_supported(header_parser::isa value)
+    {
+        return static_cast<int>(value) <= static_cast<int>(header_parser::detect_isa());
+    }
+
+    // Best of the timed runs after one untimed warm-up pass
+    void run_bench(const header_parser &parser, const uint8_t *buffer, size_t length, int iterations,
+                   std::vector<record_index_entry> &index, const char *label)
+    {
+        parse_result result;
+        double best = 0.0;
+        for (int i = 0; i <= iterations; i++)
+        {
+            index.clear();
+            auto start = std::chrono::steady_clock::now();
+            result = parser.parse(buffer, length, index);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (i > 0)
+            {
+                best = std::max(best, length / elapsed.count() / 1e9);
+            }
+        }
+
+        std::cout << std::left << std::setw(16) << label << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(8) << best << " GB/s  records " << result.recordCount
+                  << " status " << status_name(result.status) << "\n";
+    }
+
+    bool expect(const char *name, const parse_result &result, parse_status status, size_t recordCount)
+    {
+        bool isPassed = result.status == status && result.recordCount == recordCount;
+        std::cout << (isPassed ? "PASS " : "FAIL ") << name << ": status " << status_name(result.status)
+                  << ", records " << result.recordCount << "\n";
+        return isPassed;
+    }
+
+    void put_record(uint8_t *buffer, size_t offset, uint32_t size)
+    {
+        uint8_t *payload = buffer + offset + sizeof(DMA_RECORD_HEADER);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            payload[i] = static_cast<uint8_t>(i * 7 + 3);
+        }
+        DMA_RECORD_HEADER header = {DMA_RECORD_HEADER_MAGIC, size, DMA_RECORD_FLAG_CHECKSUM,
+                                    header_parser::checksum(payload, size, header_parser::isa::scalar)};
+        std::memcpy(buffer + offset, &header, sizeof(header));
+    }
+
+    // Compares every supported ISA against scalar and parses crafted bad buffers
+    bool self_check()
+    {
+        bool isPassed = true;
+
+        std::vector<uint8_t> data(4096 + 8);
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            data[i] = static_cast<uint8_t>(i * 131 + 17);
+        }
+        size_t mismatches = 0;
+        for (size_t offset = 0; offset < 8; offset++)
+        {
+            for (size_t length = 0; length + offset <= data.size(); length++)
+            {
+                uint32_t expected = header_parser::checksum(data.data() + offset, length, header_parser::isa::scalar);
+                for (header_parser::isa value : g_isas)
+                {
+                    if (is_supported(value) && header_parser::checksum(data.data() + offset, length, value) != expected)
+                    {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+        std::cout << (mismatches ? "FAIL " : "PASS ") << "checksum agreement across ISAs: " << mismatches << " mismatches\n";
+        isPassed &= mismatches == 0;
+
+        for (header_parser::isa value : g_isas)
+        {
+            if (!is_supported(value))
+            {
+                continue;
+            }
+            std::cout << "-- " << header_parser::isa_name(value) << "\n";
+
+            header_parser parser(value, true);
+            std::vector<record_index_entry> index;
+            std::vector<uint8_t> buffer(1024, 0);
+
+            put_record(buffer.data(), 0, 100);
+            put_record(buffer.data(), 128, 200);
+            isPassed &= expect("zero terminated", parser.parse(buffer.data(), buffer.size(), index), parse_status::ok, 2);
+            isPassed &= expect("exact end", parser.parse(buffer.data(), 384, index), parse_status::ok, 2);
+            isPassed &= expect("empty buffer", parser.parse(buffer.data() + 384, 256, index), parse_status::ok, 0);
+            isPassed &= expect("payload truncated", parser.parse(buffer.data(), 300, index), parse_status::truncated, 1);
+            isPassed &= expect("header truncated", parser.parse(buffer.data(), 136, index), parse_status::truncated, 1);
+
+            std::vector<uint8_t> corrupt = buffer;
+            corrupt[128] ^= 0xFF;
+            isPassed &= expect("bad magic", parser.parse(corrupt.data(), corrupt.size(), index), parse_status::invalid_header, 1);
+
+            corrupt = buffer;
+            uint32_t hugeSize = 0xFFFFFFFF;
+            std::memcpy(corrupt.data() + 128 + 4, &hugeSize, sizeof(hugeSize));
+            isPassed &= expect("bad size", parser.parse(corrupt.data(), corrupt.size(), index), parse_status::invalid_header, 1);
+
+            corrupt = buffer;
+            corrupt[128 + sizeof(DMA_RECORD_HEADER) + 50] ^= 0x01;
+            isPassed &= expect("bad checksum", parser.parse(corrupt.data(), corrupt.size(), index), parse_status::checksum_mismatch, 1);
+        }
+
+        return isPassed;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "--check") == 0)
+    {
+        return self_check() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    uint32_t payloadSize = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 0)) : 4096;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+    const size_t length = DESCRIPTOR_BUFFER_SIZE;
+
+    uint8_t *buffer = static_cast<uint8_t *>(std::aligned_alloc(DMA_RECORD_ALIGNMENT, length));
+    if (buffer == nullptr)
+    {
+        std::cerr << "Failed to allocate " << length << " bytes\n";
+        return EXIT_FAILURE;
+    }
+    fill_records(buffer, length, payloadSize);
+
+    std::cout << "Buffer " << (length >> 20) << " MB, payload " << payloadSize << " bytes, detected "
+              << header_parser::isa_name(header_parser::detect_isa()) << "\n";
+
+    std::vector<record_index_entry> index;
+    index.reserve(length / DMA_RECORD_ALIGNMENT);
+
+    // The header walk is the same scalar code for every ISA, so it is measured once
+    run_bench(header_parser(header_parser::isa::scalar, false), buffer, length, iterations, index, "headers");
+
+    for (header_parser::isa value : g_isas)
+    {
+        if (is_supported(value))
+        {
+            std::string label = std::string("checksum ") + header_parser::isa_name(value);
+            run_bench(header_parser(value, true), buffer, length, iterations, index, label.c_str());
+        }
+    }
+
+    std::free(buffer);
+    return EXIT_SUCCESS;
+}
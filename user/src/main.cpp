@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include "driver_interface.h"
+#include "driver_trace.h"
 
 void print_usage()
 {
@@ -12,6 +13,11 @@ void print_usage()
               << "  start_stop_DMA_channel <uint8_t channel> <bool start> <bool cycle>\n"
               << "  start_stop_DMA_global <bool start> <bool rx>\n"
               << "  start_DMA_configure\n"
+              << "  trace <bool enable>\n"
+              << "  trace_dump <file>\n"
+              << "  record_start <file> <bool payloads>\n"
+              << "  record_stop\n"
+              << "  wait_completions <uint32_t count> <int timeout ms>\n"
               << "  exit (to quit)\n";
 }
 
@@ -103,6 +109,70 @@ int main()
                 driver.start_DMA_configure(startDmaConfig, memoryData);
                 std::cout << "DMA configured\n";
             }
+            else if (cmd == "trace")
+            {
+                bool isEnable;
+                if (iss >> isEnable)
+                {
+                    driver_trace::enable(isEnable);
+                    std::cout << "Tracing " << (isEnable ? "enabled" : "disabled") << "\n";
+                }
+                else
+                {
+                    std::cout << "Invalid parameters for trace\n";
+                }
+            }
+            else if (cmd == "trace_dump")
+            {
+                std::string path;
+                if (iss >> path)
+                {
+                    driver_trace::dump(path.c_str());
+                    std::cout << "Trace written to " << path << "\n";
+                }
+                else
+                {
+                    std::cout << "Invalid parameters for trace_dump\n";
+                }
+            }
+            else if (cmd == "record_start")
+            {
+                std::string path;
+                bool isPayloadRecorded;
+                if (iss >> path >> isPayloadRecorded)
+                {
+                    driver.start_recording(path.c_str(), isPayloadRecorded);
+                    std::cout << "Recording to " << path << (isPayloadRecorded ? " with payloads" : " with payload hashes") << "\n";
+                }
+                else
+                {
+                    std::cout << "Invalid parameters for record_start\n";
+                }
+            }
+            else if (cmd == "record_stop")
+            {
+                driver.stop_recording();
+                std::cout << "Recording stopped\n";
+            }
+            else if (cmd == "wait_completions")
+            {
+                uint32_t count;
+                int timeoutMs;
+                if (iss >> count >> timeoutMs)
+                {
+                    uint32_t received = 0;
+                    dma_completion completion;
+                    while (received < count && driver.wait_completion(completion, timeoutMs))
+                    {
+                        received++;
+                    }
+                    std::cout << "Received " << received << " of " << count << " completions\n";
+                }
+                else
+                {
+                    std::cout << "Invalid parameters for wait_completions\n";
+                }
+            }
             else if (cmd == "exit")
             {
                 break;
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "header_parser.h"
+#include "session_replay.h"
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: replay_bench <session file> [speed (0: as fast as possible)] [hash|parse]\n";
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        double speed = argc > 2 ? std::atof(argv[2]) : 0.0;
+        bool isParse = argc > 3 && std::strcmp(argv[3], "parse") == 0;
+
+        session_replay replay(argv[1], speed);
+        std::cout << "Session: " << replay.completion_count() << " completions, " << replay.register_ops().size()
+                  << " register ops, payloads " << (replay.is_payload_recorded() ? "recorded" : "hashed")
+                  << ", consumer " << (isParse ? "parse" : "hash") << "\n";
+        if (isParse && !replay.is_payload_recorded())
+        {
+            // Zero-filled buffers stop at the terminator at once, so the figures would be meaningless
+            std::cerr << "The parse consumer needs a session recorded with payloads\n";
+            return EXIT_FAILURE;
+        }
+
+        // Consumer stage under test: hash every buffer, or parse header-framed records
+        header_parser parser;
+        std::vector<record_index_entry> index;
+        uint64_t bytes = 0;
+        uint64_t records = 0;
+        uint64_t failedBuffers = 0;
+        uint64_t sink = 0;
+
+        completion_source &source = replay;
+        dma_completion completion;
+        auto start = std::chrono::steady_clock::now();
+        while (!replay.is_finished())
+        {
+            if (!source.wait_completion(completion, TIMEOUT_MS_IOCTL))
+            {
+                continue;
+            }
+
+            if (isParse)
+            {
+                index.clear();
+                parse_result result = parser.parse(completion.buffer, completion.size, index);
+                records += result.recordCount;
+                if (result.status != parse_status::ok)
+                {
+                    failedBuffers++;
+                }
+            }
+            else
+            {
+                sink ^= session_recorder::payload_hash(completion.buffer, completion.size);
+            }
+            bytes += completion.size;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (replay.completion_count() == 0)
+        {
+            std::cout << "No completions to replay\n";
+            return EXIT_SUCCESS;
+        }
+
+        std::cout << "Elapsed " << elapsed.count() << " s, " << replay.completion_count() / elapsed.count()
+                  << " completions/s, " << bytes / elapsed.count() / 1e9 << " GB/s";
+        if (isParse)
+        {
+            std::cout << ", " << records << " records, " << failedBuffers << " buffers not ok";
+        }
+        std::cout << " (" << std::hex << sink << std::dec << ")\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+#include "session_recorder.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+session_recorder::~session_recorder()
+{
+    // A failure nobody collected through close() is dropped here
+    close();
+}
+
+void session_recorder::open(const char *path, bool isPayloadRecorded)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_)
+    {
+        throw std::runtime_error("Recording already in progress");
+    }
+
+    file_.clear();
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_)
+    {
+        throw std::runtime_error(std::string("Failed to open session file ") + path);
+    }
+
+    session_file_header header = {SESSION_FILE_MAGIC, SESSION_FILE_VERSION, static_cast<uint16_t>(isPayloadRecorded)};
+    if (!file_.write(reinterpret_cast<const char *>(&header), sizeof(header)))
+    {
+        file_.close();
+        throw std::runtime_error(std::string("Failed to write session file ") + path);
+    }
+
+    isFailed_ = false;
+    isPayloadRecorded_ = isPayloadRecorded;
+    startNs_ = timestamp_ns();
+    fileOffset_ = sizeof(header);
+    isOpen_ = true;
+}
+
+bool session_recorder::close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_)
+    {
+        isOpen_ = false;
+        file_.close();
+        if (!file_)
+        {
+            isFailed_ = true;
+        }
+    }
+
+    bool isSucceeded = !isFailed_;
+    isFailed_ = false;
+    return isSucceeded;
+}
+
+void session_recorder::record_register(bool isWrite, const REGESTRY_PARAMS &params)
+{
+    if (!is_open())
+    {
+        return;
+    }
+    write_record(isWrite ? session_record_type::register_write : session_record_type::register_read, timestamp_ns(), &params, sizeof(params), nullptr, 0);
+}
+
+void session_recorder::record_configuration(const GLOBAL_START_DMA_CONFIGURATION &configuration)
+{
+    if (!is_open())
+    {
+        return;
+    }
+    write_record(session_record_type::configuration, timestamp_ns(), &configuration, sizeof(configuration), nullptr, 0);
+}
+
+void session_recorder::record_completion(const dma_completion &completion, uint64_t timestampNs)
+{
+    if (!is_open())
+    {
+        return;
+    }
+
+    // The hash is only needed when the payload itself is not stored
+    uint64_t hash = isPayloadRecorded_.load(std::memory_order_relaxed) ? 0 : payload_hash(completion.buffer, completion.size);
+    session_completion_record body = {completion.channel, completion.descriptor, completion.size, 0, hash};
+    write_record(session_record_type::completion, timestampNs, &body, sizeof(body), completion.buffer, completion.size);
+}
+
+uint64_t session_recorder::timestamp_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t session_recorder::payload_hash(const void *data, size_t length)
+{
+    // XXH64 with seed 0: four independent lanes of multiply-rotate rounds and an avalanche finalizer
+    const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t prime3 = 0x165667B19E3779F9ULL;
+    const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+    auto rotl = [](uint64_t value, int bits)
+    { return (value << bits) | (value >> (64 - bits)); };
+    auto round = [&](uint64_t acc, uint64_t word)
+    { return rotl(acc + word * prime2, 31) * prime1; };
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    size_t i = 0;
+    uint64_t hash;
+    if (length >= 32)
+    {
+        uint64_t lanes[4] = {prime1 + prime2, prime2, 0, 0 - prime1};
+        for (; i + 32 <= length; i += 32)
+        {
+            uint64_t words[4];
+            std::memcpy(words, bytes + i, sizeof(words));
+            for (int lane = 0; lane < 4; lane++)
+            {
+                lanes[lane] = round(lanes[lane], words[lane]);
+            }
+        }
+
+        hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+        for (uint64_t lane : lanes)
+        {
+            hash = (hash ^ round(0, lane)) * prime1 + prime4;
+        }
+    }
+    else
+    {
+        hash = prime5;
+    }
+    hash += length;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = rotl(hash ^ round(0, word), 27) * prime1 + prime4;
+    }
+    if (i + 4 <= length)
+    {
+        uint32_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = rotl(hash ^ (word * prime1), 23) * prime2 + prime3;
+        i += 4;
+    }
+    for (; i < length; i++)
+    {
+        hash = rotl(hash ^ (bytes[i] * prime5), 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void session_recorder::write_record(session_record_type type, uint64_t timestampNs, const void *body, uint32_t length, const void *payload, uint32_t payloadLength)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isOpen_)
+    {
+        return;
+    }
+    if (!isPayloadRecorded_)
+    {
+        payloadLength = 0;
+    }
+
+    // Pad so the payload lands on an aligned file offset, and so on an aligned address once mapped
+    static const char zeros[SESSION_PAYLOAD_ALIGNMENT] = {};
+    uint64_t bodyEnd = fileOffset_ + sizeof(session_record_header) + length;
+    uint32_t padding = payloadLength ? static_cast<uint32_t>(ALIGN_X(bodyEnd, static_cast<uint64_t>(SESSION_PAYLOAD_ALIGNMENT)) - bodyEnd) : 0;
+
+    // A timestamp taken before open() is clamped to the start of the recording
+    uint64_t relativeNs = timestampNs > startNs_ ? timestampNs - startNs_ : 0;
+    session_record_header header = {static_cast<uint8_t>(type), {0, 0, 0}, length + padding + payloadLength, relativeNs};
+    file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file_.write(static_cast<const char *>(body), length);
+    if (payloadLength)
+    {
+        file_.write(zeros, padding);
+        file_.write(static_cast<const char *>(payload), payloadLength);
+    }
+    fileOffset_ = bodyEnd + padding + payloadLength;
+    if (!file_)
+    {
+        // Keep device operations going; stop_recording() reports the failure
+        isOpen_ = false;
+        isFailed_ = true;
+        file_.close();
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include "Public.h"
+#include "completion_source.h"
+
+#define SESSION_FILE_MAGIC 0x4E535353 ///< "SSSN"
+#define SESSION_FILE_VERSION 2
+#define SESSION_PAYLOAD_ALIGNMENT 64 ///< Recorded payloads start on this file offset boundary
+
+enum class session_record_type : uint8_t
+{
+    register_write, ///< Body: REGESTRY_PARAMS
+    register_read,  ///< Body: REGESTRY_PARAMS with the value read
+    configuration,  ///< Body: GLOBAL_START_DMA_CONFIGURATION
+    completion,     ///< Body: session_completion_record, zero padding up to SESSION_PAYLOAD_ALIGNMENT, payload (when recorded)
+};
+
+struct __attribute__((packed)) session_file_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t isPayloadRecorded; ///< 0: completions carry only a payload hash
+};
+
+struct __attribute__((packed)) session_record_header
+{
+    uint8_t type;
+    uint8_t reserved[3];
+    uint32_t length;      ///< Body bytes following this header, padding included
+    uint64_t timestampNs; ///< Since the start of the recording
+};
+
+struct __attribute__((packed)) session_completion_record
+{
+    uint32_t channel;
+    uint32_t descriptor;
+    uint32_t size;
+    uint32_t reserved;
+    uint64_t payloadHash; ///< session_recorder::payload_hash of the buffer, 0 when the payload is recorded
+};
+
+/*
+ * Writes a driver session to a compact binary file: register operations,
+ * DMA configuration and the completion stream with timestamps. Payloads are
+ * stored in full or as a hash. All calls are thread safe and return at once
+ * when no recording is open. A write error ends the recording without
+ * throwing into the caller; close() then reports it.
+ */
+class session_recorder
+{
+public:
+    session_recorder() = default;
+    ~session_recorder();
+
+    void open(const char *path, bool isPayloadRecorded);
+    ///< Returns false when the recording was cut short by a write error
+    bool close();
+
+    bool is_open() const
+    {
+        return isOpen_.load(std::memory_order_relaxed);
+    }
+
+    void record_register(bool isWrite, const REGESTRY_PARAMS &params);
+    void record_configuration(const GLOBAL_START_DMA_CONFIGURATION &configuration);
+    ///< timestampNs is timestamp_ns() taken when the completion was seen, before any recording work
+    void record_completion(const dma_completion &completion, uint64_t timestampNs);
+
+    static uint64_t timestamp_ns();
+    static uint64_t payload_hash(const void *data, size_t length);
+
+private:
+    ///< payload is dropped unless the recording stores payloads
+    void write_record(session_record_type type, uint64_t timestampNs, const void *body, uint32_t length, const void *payload, uint32_t payloadLength);
+
+    std::atomic<bool> isOpen_{false};
+    std::mutex mutex_;
+    std::ofstream file_;
+    std::atomic<bool> isPayloadRecorded_{false};
+    bool isFailed_ = false;
+    uint64_t startNs_ = 0;
+    uint64_t fileOffset_ = 0; ///< Bytes written so far, for payload alignment
+};
+
+#endif // SESSION_RECORDER_H
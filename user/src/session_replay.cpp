@@ -0,0 +1,218 @@
+#include "session_replay.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+session_replay::session_replay(const char *path, double speed)
+    : speed_(speed)
+{
+    if (speed < 0)
+    {
+        throw std::runtime_error("Invalid replay speed");
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error(std::string("Failed to open session file ") + path);
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) < 0 || static_cast<size_t>(fileStat.st_size) < sizeof(session_file_header))
+    {
+        ::close(fd);
+        throw std::runtime_error(std::string("Not a session file: ") + path);
+    }
+
+    // Populate the whole mapping now so replay never waits on the disk
+    size_t mapSize = static_cast<size_t>(fileStat.st_size);
+    void *mapped = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error(std::string("Failed to map session file ") + path);
+    }
+    map_.data = mapped;
+    map_.size = mapSize;
+
+    const uint8_t *data = static_cast<const uint8_t *>(map_.data);
+    session_file_header fileHeader;
+    std::memcpy(&fileHeader, data, sizeof(fileHeader));
+    if (fileHeader.magic != SESSION_FILE_MAGIC || fileHeader.version != SESSION_FILE_VERSION)
+    {
+        throw std::runtime_error(std::string("Not a session file: ") + path);
+    }
+    isPayloadRecorded_ = fileHeader.isPayloadRecorded != 0;
+
+    // Index the file once. A record cut short by an interrupted recording ends the session.
+    uint32_t maxSize = 0;
+    size_t offset = sizeof(fileHeader);
+    while (offset + sizeof(session_record_header) <= mapSize)
+    {
+        session_record_header header;
+        std::memcpy(&header, data + offset, sizeof(header));
+        offset += sizeof(header);
+        if (header.length > mapSize - offset)
+        {
+            break;
+        }
+        const uint8_t *body = data + offset;
+        size_t bodyOffset = offset;
+        offset += header.length;
+
+        switch (static_cast<session_record_type>(header.type))
+        {
+        case session_record_type::register_write:
+        case session_record_type::register_read:
+            if (header.length == sizeof(REGESTRY_PARAMS))
+            {
+                recorded_register_op op = {header.timestampNs, header.type == static_cast<uint8_t>(session_record_type::register_write), {}};
+                std::memcpy(&op.params, body, sizeof(op.params));
+                registerOps_.push_back(op);
+            }
+            break;
+
+        case session_record_type::configuration:
+            if (header.length == sizeof(configuration_))
+            {
+                std::memcpy(&configuration_, body, sizeof(configuration_));
+                hasConfiguration_ = true;
+            }
+            break;
+
+        case session_record_type::completion:
+        {
+            completion_entry entry = {header.timestampNs, nullptr, {}};
+            if (header.length < sizeof(entry.record))
+            {
+                break;
+            }
+            std::memcpy(&entry.record, body, sizeof(entry.record));
+
+            // The payload follows the record at the next aligned file offset
+            size_t recordEnd = bodyOffset + sizeof(entry.record);
+            size_t payloadOffset = ALIGN_X(recordEnd, static_cast<size_t>(SESSION_PAYLOAD_ALIGNMENT));
+            if (entry.record.channel >= MAX_NUM_CHANNELS || entry.record.descriptor >= MAX_NUM_DESCRIPTORS ||
+                entry.record.size > DESCRIPTOR_BUFFER_SIZE ||
+                (isPayloadRecorded_ && header.length != payloadOffset - bodyOffset + entry.record.size))
+            {
+                throw std::runtime_error("Corrupted completion record in session file");
+            }
+            entry.payload = data + payloadOffset;
+            maxSize = std::max(maxSize, entry.record.size);
+            completions_.push_back(entry);
+            break;
+        }
+
+        default:
+            // Unknown record types are skipped
+            break;
+        }
+    }
+
+    if (!isPayloadRecorded_)
+    {
+        size_t zeroSize = ALIGN_X(std::max<size_t>(maxSize, 1), static_cast<size_t>(SESSION_PAYLOAD_ALIGNMENT));
+        zeroBuffer_.reset(static_cast<uint8_t *>(std::aligned_alloc(SESSION_PAYLOAD_ALIGNMENT, zeroSize)));
+        if (!zeroBuffer_)
+        {
+            throw std::bad_alloc();
+        }
+        std::memset(zeroBuffer_.get(), 0, zeroSize);
+        for (completion_entry &entry : completions_)
+        {
+            entry.payload = zeroBuffer_.get();
+        }
+    }
+}
+
+session_replay::file_mapping::~file_mapping()
+{
+    if (data != nullptr)
+    {
+        munmap(data, size);
+    }
+}
+
+bool session_replay::wait_completion(dma_completion &completion, int timeoutMs)
+{
+    if (next_ >= completions_.size())
+    {
+        return false;
+    }
+
+    const completion_entry &entry = completions_[next_];
+    if (speed_ > 0)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (!isStarted_)
+        {
+            start_ = now;
+            isStarted_ = true;
+        }
+
+        auto due = start_ + std::chrono::nanoseconds(static_cast<int64_t>((entry.timestampNs - completions_.front().timestampNs) / speed_));
+        if (timeoutMs >= 0 && due > now + std::chrono::milliseconds(timeoutMs))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            return false;
+        }
+        std::this_thread::sleep_until(due);
+    }
+
+    completion.channel = entry.record.channel;
+    completion.descriptor = entry.record.descriptor;
+    completion.buffer = entry.payload;
+    completion.size = entry.record.size;
+    lastPayloadHash_ = entry.record.payloadHash;
+    next_++;
+    return true;
+}
+
+bool session_replay::is_finished() const
+{
+    return next_ >= completions_.size();
+}
+
+void session_replay::rewind()
+{
+    next_ = 0;
+    lastPayloadHash_ = 0;
+    isStarted_ = false;
+}
+
+bool session_replay::is_payload_recorded() const
+{
+    return isPayloadRecorded_;
+}
+
+bool session_replay::has_configuration() const
+{
+    return hasConfiguration_;
+}
+
+const GLOBAL_START_DMA_CONFIGURATION &session_replay::configuration() const
+{
+    return configuration_;
+}
+
+const std::vector<recorded_register_op> &session_replay::register_ops() const
+{
+    return registerOps_;
+}
+
+size_t session_replay::completion_count() const
+{
+    return completions_.size();
+}
+
+uint64_t session_replay::last_payload_hash() const
+{
+    return lastPayloadHash_;
+}
@@ -0,0 +1,85 @@
+#ifndef SESSION_REPLAY_H
+#define SESSION_REPLAY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "Public.h"
+#include "completion_source.h"
+#include "session_recorder.h"
+
+struct recorded_register_op
+{
+    uint64_t timestampNs;
+    bool isWrite;
+    REGESTRY_PARAMS params;
+};
+
+/*
+ * Replays the completion stream of a session file without a device. With
+ * speed 1.0 completions are delivered at the recorded pace, other positive
+ * values scale it, and 0 delivers them as fast as possible. The file is
+ * mapped and populated up front so no I/O happens during replay; payload
+ * pointers point into the mapping and are SESSION_PAYLOAD_ALIGNMENT aligned.
+ * Sessions recorded without payloads deliver zero-filled buffers of the
+ * recorded size; compare last_payload_hash() with the consumer's own hash.
+ */
+class session_replay : public completion_source
+{
+public:
+    session_replay(const char *path, double speed);
+
+    session_replay(const session_replay &) = delete;
+    session_replay &operator=(const session_replay &) = delete;
+
+    bool wait_completion(dma_completion &completion, int timeoutMs) override;
+
+    bool is_finished() const;
+    void rewind();
+
+    bool is_payload_recorded() const;
+    bool has_configuration() const;
+    const GLOBAL_START_DMA_CONFIGURATION &configuration() const;
+    const std::vector<recorded_register_op> &register_ops() const;
+    size_t completion_count() const;
+    ///< Recorded hash of the last delivered completion, 0 for sessions with payloads
+    uint64_t last_payload_hash() const;
+
+private:
+    // Unmaps on destruction, also when the constructor throws after mapping
+    struct file_mapping
+    {
+        void *data = nullptr;
+        size_t size = 0;
+
+        file_mapping() = default;
+        file_mapping(const file_mapping &) = delete;
+        file_mapping &operator=(const file_mapping &) = delete;
+        ~file_mapping();
+    };
+
+    struct completion_entry
+    {
+        uint64_t timestampNs;
+        const uint8_t *payload; ///< Into the mapping, or the zero-filled buffer
+        session_completion_record record;
+    };
+
+    file_mapping map_;
+    double speed_;
+    bool isPayloadRecorded_ = false;
+    bool hasConfiguration_ = false;
+    GLOBAL_START_DMA_CONFIGURATION configuration_ = {};
+    std::vector<recorded_register_op> registerOps_;
+    std::vector<completion_entry> completions_;
+    size_t next_ = 0;
+    uint64_t lastPayloadHash_ = 0;
+    bool isStarted_ = false;
+    std::chrono::steady_clock::time_point start_;
+    std::unique_ptr<uint8_t, decltype(&std::free)> zeroBuffer_{nullptr, &std::free}; ///< Shared by all completions of a hash-only session
+};
+
+#endif // SESSION_REPLAY_H
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "driver_trace.h"
+
+namespace
+{
+    struct decoded_record
+    {
+        uint32_t threadId;
+        trace_record record;
+    };
+
+    const char *event_name(uint16_t event)
+    {
+        switch (static_cast<trace_event>(event))
+        {
+        case trace_event::register_write:
+            return "register_write";
+        case trace_event::register_read:
+            return "register_read";
+        case trace_event::event_created:
+            return "event_created";
+        case trace_event::dma_channel:
+            return "dma_channel";
+        case trace_event::dma_global:
+            return "dma_global";
+        case trace_event::dma_configure:
+            return "dma_configure";
+        case trace_event::completion:
+            return "completion";
+        case trace_event::error:
+            return "error";
+        default:
+            return "unknown";
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: trace_decode <trace file>\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    trace_file_header fileHeader;
+    if (!file.read(reinterpret_cast<char *>(&fileHeader), sizeof(fileHeader)) ||
+        fileHeader.magic != DRIVER_TRACE_FILE_MAGIC || fileHeader.version != DRIVER_TRACE_FILE_VERSION ||
+        fileHeader.recordSize != sizeof(trace_record))
+    {
+        std::cerr << "Not a trace file: " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<decoded_record> records;
+    for (uint32_t thread = 0; thread < fileHeader.threadCount; thread++)
+    {
+        trace_thread_header threadHeader;
+        if (!file.read(reinterpret_cast<char *>(&threadHeader), sizeof(threadHeader)))
+        {
+            std::cerr << "Truncated trace file\n";
+            return EXIT_FAILURE;
+        }
+        if (threadHeader.dropped)
+        {
+            std::cerr << "Thread " << threadHeader.threadId << ": " << threadHeader.dropped << " records dropped\n";
+        }
+
+        for (uint32_t i = 0; i < threadHeader.recordCount; i++)
+        {
+            decoded_record decoded = {threadHeader.threadId, {}};
+            if (!file.read(reinterpret_cast<char *>(&decoded.record), sizeof(trace_record)))
+            {
+                std::cerr << "Truncated trace file\n";
+                return EXIT_FAILURE;
+            }
+            records.push_back(decoded);
+        }
+    }
+
+    // Merge the per-thread rings into one timeline
+    std::stable_sort(records.begin(), records.end(), [](const decoded_record &a, const decoded_record &b)
+                     { return a.record.timestampNs < b.record.timestampNs; });
+
+    uint64_t start = records.empty() ? 0 : records.front().record.timestampNs;
+    uint64_t previous = start;
+    for (const decoded_record &decoded : records)
+    {
+        const trace_record &record = decoded.record;
+        std::cout << "+" << (record.timestampNs - start) << "ns (" << (record.timestampNs - previous) << "ns) tid "
+                  << decoded.threadId << " " << event_name(record.event) << " " << record.arg0 << " 0x" << std::hex
+                  << record.arg1 << " 0x" << record.arg2 << std::dec << "\n";
+        previous = record.timestampNs;
+    }
+
+    return EXIT_SUCCESS;
+}